@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace trezz::bench {
+
+/*
+
+Minimal micro-benchmark harness.
+
+A benchmark is a function run in a loop. The harness calibrates the number of iterations per
+sample so that a sample lasts at least options::min_sample_time, runs warmup samples, then measures
+options::repetitions samples and reports the time per iteration percentiles of the samples. When
+options::min_sample_time is zero, there is no calibration and a sample is a single call.
+
+Results are written as JSON to compare runs:
+
+    trezz::bench::runner r{};
+    r.run("sum", { { "width", "16" } }, [&] { trezz::bench::do_not_optimize(sum(v)); });
+    r.write_json(std::cout);
+
+*/
+
+// Prevent the compiler from optimizing away the computation of the given value.
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    const volatile auto* p = &value;
+    std::ignore = p;
+#endif
+}
+
+// Prevent the compiler from reordering memory accesses across this call.
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct options
+{
+    // Number of samples run and discarded before measuring.
+    size_t warmup{ 3 };
+
+    // Number of measured samples.
+    size_t repetitions{ 30 };
+
+    // Minimum duration of a sample, or zero for samples of a single call, without calibration.
+    std::chrono::nanoseconds min_sample_time{ std::chrono::milliseconds{ 2 } };
+};
+
+struct result
+{
+    std::string name{};
+
+    // Workload parameters, e.g. { "width", "16" }.
+    std::vector<std::pair<std::string, std::string>> params{};
+
+    // Number of iterations per sample.
+    size_t iterations{};
+
+    // Time per iteration of each sample in nanoseconds, sorted.
+    std::vector<double> samples{};
+
+    // Return the time per iteration at the given percentile, in [0, 100], using the nearest rank.
+    double percentile(double p) const
+    {
+        if (samples.empty()) {
+            return 0;
+        }
+        const auto rank =
+            static_cast<size_t>(std::ceil(p / 100 * static_cast<double>(samples.size())));
+        return samples[std::clamp(rank, size_t{ 1 }, samples.size()) - 1];
+    }
+
+    double mean() const
+    {
+        double sum = 0;
+        for (const auto s : samples) {
+            sum += s;
+        }
+        return samples.empty() ? 0 : sum / static_cast<double>(samples.size());
+    }
+};
+
+namespace detail {
+
+template<typename Fn>
+std::chrono::nanoseconds run_sample(const Fn& f, size_t iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        f();
+        clobber_memory();
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+inline void write_json_string(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            os << ' ';
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+} // namespace detail
+
+// Run benchmarks and collect their results.
+class runner
+{
+public:
+    explicit runner(options opts = {})
+      : _options{ opts }
+    {
+    }
+
+    // Run the given function as a benchmark with the given name and parameters.
+    template<typename Fn>
+    const result& run(std::string name,
+                      std::vector<std::pair<std::string, std::string>> params,
+                      const Fn& f)
+    {
+        size_t iterations = 1;
+        if (_options.min_sample_time > std::chrono::nanoseconds::zero()) {
+            while (detail::run_sample(f, iterations) < _options.min_sample_time &&
+                   iterations < (size_t{ 1 } << 40)) {
+                iterations *= 2;
+            }
+        }
+
+        for (size_t i = 0; i < _options.warmup; ++i) {
+            detail::run_sample(f, iterations);
+        }
+
+        result r{ std::move(name), std::move(params), iterations, {} };
+        r.samples.reserve(_options.repetitions);
+        for (size_t i = 0; i < _options.repetitions; ++i) {
+            const auto elapsed = detail::run_sample(f, iterations);
+            r.samples.push_back(static_cast<double>(elapsed.count()) /
+                                static_cast<double>(iterations));
+        }
+        std::sort(r.samples.begin(), r.samples.end());
+
+        _results.push_back(std::move(r));
+        return _results.back();
+    }
+
+    const std::vector<result>& results() const noexcept { return _results; }
+
+    // Write the results as a JSON document.
+    void write_json(std::ostream& os) const
+    {
+        os << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < _results.size(); ++i) {
+            const auto& r = _results[i];
+            os << (i == 0 ? "\n" : ",\n") << "    { \"name\": ";
+            detail::write_json_string(os, r.name);
+            os << ", \"params\": {";
+            for (size_t j = 0; j < r.params.size(); ++j) {
+                os << (j == 0 ? " " : ", ");
+                detail::write_json_string(os, r.params[j].first);
+                os << ": ";
+                detail::write_json_string(os, r.params[j].second);
+            }
+            os << (r.params.empty() ? "}" : " }") << ", \"iterations\": " << r.iterations
+               << ", \"repetitions\": " << r.samples.size() << ", \"ns_per_op\": { \"min\": "
+               << r.percentile(0) << ", \"p50\": " << r.percentile(50)
+               << ", \"p90\": " << r.percentile(90) << ", \"max\": " << r.percentile(100)
+               << ", \"mean\": " << r.mean() << " } }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+private:
+    options _options{};
+    std::vector<result> _results{};
+};
+
+} // namespace trezz::bench
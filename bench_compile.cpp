@@ -0,0 +1,166 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Compiler, flags of the build type and include directory used to compile the generated sources,
+// set by the build.
+#ifndef TREZZ_BENCH_CXX
+#define TREZZ_BENCH_CXX "c++"
+#endif
+#ifndef TREZZ_BENCH_CXX_FLAGS
+#define TREZZ_BENCH_CXX_FLAGS ""
+#endif
+#ifndef TREZZ_BENCH_INCLUDE_DIR
+#define TREZZ_BENCH_INCLUDE_DIR "."
+#endif
+
+using namespace trezz;
+
+namespace {
+
+// Kind of generated source.
+enum class variant
+{
+    // Reflected struct used with reflstruct::each and envconfig.
+    reflected,
+
+    // Reflected struct with annotations looked up with annotation::get and annotation::has.
+    annotation,
+
+    // Hand-written equivalent of the reflected struct.
+    baseline,
+};
+
+const char* variant_name(variant v)
+{
+    switch (v) {
+        case variant::reflected:
+            return "compile";
+        case variant::annotation:
+            return "compile/annotation";
+        case variant::baseline:
+            break;
+    }
+    return "compile/baseline";
+}
+
+// Return the source of a struct of the given number of int members.
+std::string generate(size_t width, variant v)
+{
+    std::string s{};
+    s += v == variant::baseline ? "#include <cstdlib>\n#include <string>\n"
+                                : "#include \"envconfig.h\"\n\nusing namespace trezz;\n";
+    s += "\nstruct wide\n{\n";
+    for (size_t i = 0; i < width; ++i) {
+        s += "    int m" + std::to_string(i) + "{};\n";
+    }
+
+    switch (v) {
+        case variant::reflected:
+            s += "\n    TREZZ_REFLSTRUCT_BEGIN(wide)\n";
+            for (size_t i = 0; i < width; ++i) {
+                const auto n = std::to_string(i);
+                s += "    TREZZ_REFLMEMBER(m" + n + ", \"envconfig:name=WIDE_M" + n + "\")\n";
+            }
+            s += "    TREZZ_REFLSTRUCT_END\n};\n\n";
+            s += "int sum(const wide& w)\n{\n"
+                 "    int sum = 0;\n"
+                 "    const trezz::reflstruct r = wide::make_trezz_reflstruct(w);\n"
+                 "    r.each([&](const auto& m) { sum += m.value; });\n"
+                 "    return sum;\n}\n\n"
+                 "void load(wide& w)\n{\n"
+                 "    trezz::envconfig::process(w);\n}\n";
+            break;
+
+        case variant::annotation:
+            s += "\n    TREZZ_REFLSTRUCT_BEGIN(wide)\n";
+            for (size_t i = 0; i < width; ++i) {
+                const auto n = std::to_string(i);
+                s += "    TREZZ_REFLMEMBER(m" + n + ", \"json:m" + n +
+                     ",omitempty envconfig:name=WIDE_M" + n + ",required map:from=m" + n +
+                     "\")\n";
+            }
+            s += "    TREZZ_REFLSTRUCT_END\n};\n\n";
+            s += "size_t lookups(const wide& w)\n{\n"
+                 "    size_t n = 0;\n"
+                 "    const trezz::reflstruct r = wide::make_trezz_reflstruct(w);\n"
+                 "    r.each([&](const auto& m) {\n"
+                 "        using M = std::decay_t<decltype(m)>;\n"
+                 "        n += annotation::get<M::annotation, \"json\", 1>().size();\n"
+                 "        n += annotation::get<M::annotation, \"envconfig\", \"name\">().size();\n"
+                 "        n += annotation::get<M::annotation, \"map\", \"from\">().size();\n"
+                 "        using annotation::has;\n"
+                 "        if constexpr (has<M::annotation, \"json\", \"omitempty\">() &&\n"
+                 "                      has<M::annotation, \"envconfig\", \"required\">()) {\n"
+                 "            n += m.value;\n"
+                 "        }\n"
+                 "    });\n"
+                 "    return n;\n}\n";
+            break;
+
+        case variant::baseline:
+            s += "};\n\nint sum(const wide& w)\n{\n    int sum = 0;\n";
+            for (size_t i = 0; i < width; ++i) {
+                s += "    sum += w.m" + std::to_string(i) + ";\n";
+            }
+            s += "    return sum;\n}\n\nvoid load(wide& w)\n{\n";
+            for (size_t i = 0; i < width; ++i) {
+                const auto n = std::to_string(i);
+                s += "    if (const char* v = std::getenv(\"WIDE_M" + n + "\")) {\n";
+                s += "        w.m" + n + " = std::stoi(v);\n    }\n";
+            }
+            s += "}\n";
+            break;
+    }
+
+    return s;
+}
+
+} // namespace
+
+// Generate structs of varying width, time their compilation and write the results as JSON to the
+// file given as argument, or to the standard output.
+int main(int argc, char** argv)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "trezz_bench_compile";
+    std::filesystem::create_directories(dir);
+
+    bench::runner r{ bench::options{ .warmup = 0, .repetitions = 3, .min_sample_time = {} } };
+
+    for (const size_t width : { 8, 32, 64, 128 }) {
+        for (const auto v : { variant::reflected, variant::annotation, variant::baseline }) {
+            const std::string stem = "wide_" + std::to_string(width) + "_" +
+                                     std::to_string(static_cast<int>(v));
+            const auto source = dir / (stem + ".cpp");
+            const auto object = dir / (stem + ".o");
+            std::ofstream{ source } << generate(width, v);
+
+            // Compile to an object file, so that code generation is part of the measure.
+            const std::string command = std::string{ "\"" TREZZ_BENCH_CXX "\" " } +
+                                        TREZZ_BENCH_CXX_FLAGS + " -std=c++20 -I\"" +
+                                        TREZZ_BENCH_INCLUDE_DIR + "\" -c \"" + source.string() +
+                                        "\" -o \"" + object.string() + "\"";
+
+            // Each sample is a single compilation: with neither warmup nor calibration, every
+            // compilation is measured.
+            r.run(variant_name(v), { { "width", std::to_string(width) } }, [&] {
+                if (std::system(command.c_str()) != 0) {
+                    std::cerr << "compilation failed: " << command << "\n";
+                    std::exit(EXIT_FAILURE);
+                }
+            });
+        }
+    }
+
+    if (argc > 1) {
+        std::ofstream os{ argv[1] };
+        r.write_json(os);
+    } else {
+        r.write_json(std::cout);
+    }
+    return 0;
+}
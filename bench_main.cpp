@@ -0,0 +1,192 @@
+#include "bench.h"
+#include "envconfig.h"
+#include "reflstruct.h"
+
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using namespace trezz;
+
+namespace {
+
+// Return the name of the member at the given position of a generated struct, as "m" followed by
+// two hexadecimal digits: "m00", "m01", ... "m3f".
+template<size_t I>
+constexpr auto member_name()
+{
+    static_assert(I < 256, "too many members");
+    constexpr char digits[] = "0123456789abcdef";
+    const char s[]{ 'm', digits[I / 16], digits[I % 16], '\0' };
+    return detail::string_literal{ s };
+}
+
+template<size_t I>
+inline constexpr auto member_name_v = member_name<I>();
+
+template<size_t Width>
+constexpr std::array<std::string_view, Width> member_names()
+{
+    return []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<std::string_view, Width>{ std::string_view{ member_name_v<Is>.data }... };
+    }(std::make_index_sequence<Width>{});
+}
+
+// Struct of the given number of int members, reflected with TREZZ_REFLSTRUCT_BEGIN and with
+// hand-written equivalents of the reflected operations as baseline.
+template<size_t Width>
+struct wide;
+
+// Call M with the given high hexadecimal digit and each low hexadecimal digit.
+#define TREZZ_BENCH_HEX(M, H)                                                                      \
+    M(H, 0) M(H, 1) M(H, 2) M(H, 3) M(H, 4) M(H, 5) M(H, 6) M(H, 7) M(H, 8) M(H, 9) M(H, a)       \
+        M(H, b) M(H, c) M(H, d) M(H, e) M(H, f)
+
+#define TREZZ_BENCH_MEMBERS_4(M) M(0, 0) M(0, 1) M(0, 2) M(0, 3)
+#define TREZZ_BENCH_MEMBERS_16(M) TREZZ_BENCH_HEX(M, 0)
+#define TREZZ_BENCH_MEMBERS_64(M)                                                                  \
+    TREZZ_BENCH_HEX(M, 0) TREZZ_BENCH_HEX(M, 1) TREZZ_BENCH_HEX(M, 2) TREZZ_BENCH_HEX(M, 3)
+
+#define TREZZ_BENCH_FIELD(a, b) int m##a##b{};
+#define TREZZ_BENCH_REFLMEMBER(a, b) TREZZ_REFLMEMBER(m##a##b, "")
+#define TREZZ_BENCH_SUM(a, b) sum += m##a##b;
+#define TREZZ_BENCH_CONTAINS(a, b) name == "m" #a #b ||
+#define TREZZ_BENCH_LOAD(a, b)                                                                     \
+    if (const char* v = env(names[0x##a##b].c_str()); v != nullptr) {                             \
+        m##a##b = static_cast<int>(std::stoll(v));                                                 \
+    }
+
+#define TREZZ_BENCH_WIDE(Width, Last)                                                              \
+    template<>                                                                                     \
+    struct wide<Width>                                                                             \
+    {                                                                                              \
+        TREZZ_BENCH_MEMBERS_##Width(TREZZ_BENCH_FIELD)                                             \
+                                                                                                   \
+        TREZZ_REFLSTRUCT_BEGIN(wide)                                                               \
+        TREZZ_BENCH_MEMBERS_##Width(TREZZ_BENCH_REFLMEMBER)                                        \
+        TREZZ_REFLSTRUCT_END                                                                       \
+                                                                                                   \
+        int sum() const                                                                            \
+        {                                                                                          \
+            int sum = 0;                                                                           \
+            TREZZ_BENCH_MEMBERS_##Width(TREZZ_BENCH_SUM) return sum;                               \
+        }                                                                                          \
+                                                                                                   \
+        const int& last() const { return Last; }                                                   \
+                                                                                                   \
+        static bool contains(std::string_view name)                                                \
+        {                                                                                          \
+            return TREZZ_BENCH_MEMBERS_##Width(TREZZ_BENCH_CONTAINS) false;                        \
+        }                                                                                          \
+                                                                                                   \
+        template<typename Env>                                                                     \
+        void load(const Env& env, const std::array<std::string, Width>& names)                     \
+        {                                                                                          \
+            TREZZ_BENCH_MEMBERS_##Width(TREZZ_BENCH_LOAD)                                          \
+        }                                                                                          \
+    };
+
+TREZZ_BENCH_WIDE(4, m03)
+TREZZ_BENCH_WIDE(16, m0f)
+TREZZ_BENCH_WIDE(64, m3f)
+
+// Environment holding a value for each member of a wide struct.
+struct environment
+{
+    // Mutable: envconfig takes a getter returning char*, like std::getenv.
+    mutable std::unordered_map<std::string_view, std::string> values{};
+
+    char* operator()(const char* name) const
+    {
+        const auto it = values.find(name);
+        return it == values.end() ? nullptr : it->second.data();
+    }
+};
+
+template<size_t Width>
+void run(bench::runner& r)
+{
+    const std::vector<std::pair<std::string, std::string>> params{ { "width",
+                                                                     std::to_string(Width) } };
+
+    // The reflected operations go through the reflstruct of references built on each call, as in
+    // user code.
+    wide<Width> w{};
+
+    r.run("each", params, [&] {
+        bench::do_not_optimize(w);
+        int sum = 0;
+        reflect(w).each([&](const auto& m) { sum += m.value; });
+        bench::do_not_optimize(sum);
+    });
+    r.run("each/baseline", params, [&] {
+        bench::do_not_optimize(w);
+        bench::do_not_optimize(w.sum());
+    });
+
+    r.run("get", params, [&] {
+        bench::do_not_optimize(w);
+        bench::do_not_optimize(reflect(w).template get<member_name_v<Width - 1>>());
+    });
+    r.run("get/baseline", params, [&] {
+        bench::do_not_optimize(w);
+        bench::do_not_optimize(w.last());
+    });
+
+    static constexpr auto names = member_names<Width>();
+    std::string_view last = names[Width - 1];
+
+    r.run("contains", params, [&] {
+        bench::do_not_optimize(last);
+        bench::do_not_optimize(reflected_t<wide<Width>>::contains(last));
+    });
+    r.run("contains/baseline", params, [&] {
+        bench::do_not_optimize(last);
+        bench::do_not_optimize(wide<Width>::contains(last));
+    });
+
+    // Uppercase member names, as looked up by envconfig.
+    static std::array<std::string, Width> upper_names{};
+    environment env{};
+    for (size_t i = 0; i < Width; ++i) {
+        upper_names[i] = std::string{ names[i] };
+        for (auto& c : upper_names[i]) {
+            c = static_cast<char>(toupper(c));
+        }
+        env.values.emplace(upper_names[i], std::to_string(i));
+    }
+
+    r.run("envconfig::process", params, [&] {
+        envconfig::detail::process(w, env);
+        bench::do_not_optimize(w);
+    });
+    r.run("envconfig::process/baseline", params, [&] {
+        w.load(env, upper_names);
+        bench::do_not_optimize(w);
+    });
+}
+
+} // namespace
+
+// Run the benchmarks and write the results as JSON to the file given as argument, or to the
+// standard output.
+int main(int argc, char** argv)
+{
+    bench::runner r{};
+
+    run<4>(r);
+    run<16>(r);
+    run<64>(r);
+
+    if (argc > 1) {
+        std::ofstream os{ argv[1] };
+        r.write_json(os);
+    } else {
+        r.write_json(std::cout);
+    }
+    return 0;
+}
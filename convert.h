@@ -0,0 +1,321 @@
+#pragma once
+
+#include "reflstruct.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace trezz {
+
+/*
+
+Conversion between reflstruct or reflected structs.
+
+Members of the destination are matched with members of the source by name, or by the name given
+in the `map` annotation configuration:
+
+    struct user_dto {
+        int64_t id{};
+        std::string user_name{};
+    };
+
+    struct user {
+        int64_t id{};
+        std::string name{};
+
+        TREZZ_REFLSTRUCT_BEGIN(user)
+        TREZZ_REFLMEMBER(id, "")
+        TREZZ_REFLMEMBER(name, "map:from=user_name")
+        TREZZ_REFLSTRUCT_END
+    };
+
+    user u = trezz::convert<user>(dto);
+
+Destination members without a match in the source keep their default value. A `map:from=` naming
+no member of the source, or an element other than `from=` and `narrow`, is a compile-time error.
+
+Members of different types are converted implicitly only: explicit constructors are not used,
+except to build a std::string from a std::string_view. Narrowing arithmetic conversions are
+rejected unless the destination member has the `map:narrow` annotation element.
+
+The copy plan is computed at compile-time. Runs of consecutive members of the same trivially
+copyable types on both sides, laid out without gaps in both structs, are copied with a single
+memcpy. Other members are assigned one by one, converted when their types differ.
+
+*/
+
+namespace detail {
+
+// Type of the value of the member at the given position of a reflstruct.
+template<typename R, size_t N>
+using member_value_t = std::remove_cvref_t<typename R::template member_type<N>::value_type>;
+
+inline constexpr size_t no_member{ std::numeric_limits<size_t>::max() };
+
+// Return the name of the source member of the member at the given position of a reflstruct.
+template<typename R, size_t N>
+constexpr std::string_view source_member_name()
+{
+    using M = typename R::template member_type<N>;
+    return annotation::get<M::annotation, "map", "from", M::literal_name>();
+}
+
+template<typename R, size_t... Is>
+constexpr std::array<std::string_view, R::nb_members> member_names(std::index_sequence<Is...>)
+{
+    return { R::template member_type<Is>::name... };
+}
+
+// Return the position of the member of the given name in the reflstruct, or no_member.
+template<typename R>
+constexpr size_t find_member(std::string_view name)
+{
+    constexpr auto names = member_names<R>(std::make_index_sequence<R::nb_members>{});
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    return no_member;
+}
+
+template<trezz::detail::string_literal Annotation, size_t N>
+constexpr size_t is_invalid_map_annotation()
+{
+    if constexpr (N == 0) {
+        return 0;
+    } else {
+        constexpr auto element = annotation::get<Annotation, "map", N>();
+        if constexpr (element == "narrow" || element.starts_with("from=")) {
+            return is_invalid_map_annotation<Annotation, N - 1>();
+        } else {
+            return N;
+        }
+    }
+}
+
+// Return the index of the first element in the annotation configuration of map that is invalid,
+// or 0 if the configuration is valid.
+template<trezz::detail::string_literal Annotation>
+constexpr size_t is_invalid_map_annotation()
+{
+    constexpr auto n = annotation::nb_configuration_elements<Annotation, "map">();
+    if constexpr (n == 0) {
+        return 0;
+    } else {
+        return is_invalid_map_annotation<Annotation, n>();
+    }
+}
+
+// Return the position of the member of the source matching the member of the destination at the
+// given position, or no_member.
+template<typename RTo, typename RFrom, size_t N>
+constexpr size_t source_member()
+{
+    using M = typename RTo::template member_type<N>;
+    static_assert(is_invalid_map_annotation<M::annotation>() == 0,
+                  "invalid map annotation element: only from= and narrow are supported");
+    constexpr size_t from = find_member<RFrom>(source_member_name<RTo, N>());
+    static_assert(from != no_member || !annotation::has<M::annotation, "map", "from">(),
+                  "map:from names no member of the source");
+    return from;
+}
+
+// Return true if the member of the destination at the given position can be part of a memcpy
+// block.
+template<typename RTo, typename RFrom, size_t N>
+constexpr bool is_bulk_copyable()
+{
+    constexpr auto from = source_member<RTo, RFrom, N>();
+    if constexpr (from == no_member) {
+        return false;
+    } else {
+        using T = member_value_t<RTo, N>;
+        return std::is_same_v<T, member_value_t<RFrom, from>> && std::is_trivially_copyable_v<T>;
+    }
+}
+
+// Copy of count consecutive members, fused in a single memcpy when bulk is true.
+struct convert_step
+{
+    size_t to{};
+    size_t from{};
+    size_t count{};
+    bool bulk{};
+};
+
+template<size_t N>
+struct convert_plan
+{
+    std::array<convert_step, N> steps{};
+    size_t size{};
+};
+
+template<typename RTo, typename RFrom, size_t... Is>
+constexpr auto make_convert_plan(std::index_sequence<Is...>)
+{
+    constexpr std::array<size_t, sizeof...(Is)> sources{ source_member<RTo, RFrom, Is>()... };
+    constexpr std::array<bool, sizeof...(Is)> bulk{ is_bulk_copyable<RTo, RFrom, Is>()... };
+
+    convert_plan<sizeof...(Is)> plan{};
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i] == no_member) {
+            continue;
+        }
+
+        if (plan.size > 0) {
+            auto& last = plan.steps[plan.size - 1];
+            if (last.bulk && bulk[i] && last.to + last.count == i &&
+                last.from + last.count == sources[i]) {
+                last.count++;
+                continue;
+            }
+        }
+
+        plan.steps[plan.size++] = { i, sources[i], 1, bulk[i] };
+    }
+
+    return plan;
+}
+
+template<typename RTo, typename RFrom>
+inline constexpr auto convert_plan_v =
+    make_convert_plan<RTo, RFrom>(std::make_index_sequence<RTo::nb_members>{});
+
+template<typename To, typename From>
+requires reflected<To> && reflected<From>
+To convert(const From& from);
+
+// True if converting a value of type S to D is not narrowing.
+template<typename D, typename S>
+concept is_non_narrowing = requires(const S& s) { D{ s }; };
+
+// True if D is a string explicitly constructible from a string view S.
+template<typename D, typename S>
+concept is_string_from_view =
+    std::is_same_v<D, std::basic_string<typename D::value_type, typename D::traits_type>> &&
+    std::is_same_v<S, std::basic_string_view<typename D::value_type, typename D::traits_type>>;
+
+// Assign the member of the source at position J to the member of the destination at position I.
+template<size_t I, size_t J, typename RTo, typename RFrom>
+void convert_member(RTo& rto, const RFrom& rfrom)
+{
+    auto& dst = rto.template member_at<I>().value;
+    const auto& src = rfrom.template member_at<J>().value;
+
+    using D = member_value_t<RTo, I>;
+    using S = member_value_t<RFrom, J>;
+
+    if constexpr (std::is_same_v<D, S>) {
+        dst = src;
+    } else if constexpr (reflected<D> && reflected<S>) {
+        dst = detail::convert<D>(src);
+    } else if constexpr (std::is_arithmetic_v<D> && std::is_arithmetic_v<S>) {
+        using M = typename RTo::template member_type<I>;
+        static_assert(is_non_narrowing<D, S> || annotation::has<M::annotation, "map", "narrow">(),
+                      "narrowing member conversion: use the map:narrow annotation to allow it");
+        dst = static_cast<D>(src);
+    } else if constexpr (std::is_convertible_v<const S&, D>) {
+        dst = src;
+    } else if constexpr (is_string_from_view<D, S>) {
+        dst = D(src);
+    } else {
+        static_assert(!std::is_same_v<D, D>, "unsupported member conversion");
+    }
+}
+
+// Return the address of the value of the member at the given position.
+template<size_t N, typename R>
+const std::byte* member_address(const R& r)
+{
+    return reinterpret_cast<const std::byte*>(std::addressof(r.template member_at<N>().value));
+}
+
+// Return true if the members [First, First + Count) are laid out without gaps in the reflstruct.
+template<size_t First, typename R, size_t... Ks>
+bool is_packed(const R& r, std::index_sequence<Ks...>)
+{
+    return ((member_address<First + Ks + 1>(r) ==
+             member_address<First + Ks>(r) + sizeof(member_value_t<R, First + Ks>)) &&
+            ...);
+}
+
+template<convert_step Step, typename RTo, typename RFrom>
+void convert_step_apply(RTo& rto, const RFrom& rfrom)
+{
+    constexpr auto gaps = std::make_index_sequence<Step.count - 1>{};
+
+    if constexpr (Step.bulk && Step.count > 1) {
+        // Checked on each conversion: the members of a reflstruct of references can be anywhere.
+        if (is_packed<Step.to>(rto, gaps) && is_packed<Step.from>(rfrom, gaps)) {
+            constexpr size_t size = []<size_t... Ks>(std::index_sequence<Ks...>) {
+                return (sizeof(member_value_t<RTo, Step.to + Ks>) + ...);
+            }(std::make_index_sequence<Step.count>{});
+            std::memcpy(std::addressof(rto.template member_at<Step.to>().value),
+                        member_address<Step.from>(rfrom),
+                        size);
+            return;
+        }
+    }
+
+    [&]<size_t... Ks>(std::index_sequence<Ks...>) {
+        (convert_member<Step.to + Ks, Step.from + Ks>(rto, rfrom), ...);
+    }(std::make_index_sequence<Step.count>{});
+}
+
+template<typename RTo, typename RFrom, size_t... Ss>
+void convert_apply(RTo& rto, const RFrom& rfrom, std::index_sequence<Ss...>)
+{
+    constexpr auto& plan = convert_plan_v<RTo, RFrom>;
+    (convert_step_apply<plan.steps[Ss]>(rto, rfrom), ...);
+}
+
+template<typename To, typename From>
+requires reflected<To> && reflected<From>
+To convert(const From& from)
+{
+    using RTo = reflected_t<To>;
+    using RFrom = reflected_t<const From>;
+
+    To to{};
+    auto&& rto = reflect(to);
+    const auto& rfrom = reflect(from);
+    convert_apply(rto, rfrom, std::make_index_sequence<convert_plan_v<RTo, RFrom>.size>{});
+    return to;
+}
+
+} // namespace detail
+
+// Return a reflstruct or struct of type To with the members matching those of the given source.
+template<typename To, typename From>
+requires reflected<To> && reflected<From>
+To convert(const From& from)
+{
+    return detail::convert<To>(from);
+}
+
+// Return the conversion of each element of the given range to the type To.
+template<typename To, std::ranges::input_range R>
+requires reflected<To> && reflected<std::ranges::range_value_t<R>>
+std::vector<To> convert_all(const R& from)
+{
+    std::vector<To> to{};
+    if constexpr (std::ranges::sized_range<R>) {
+        to.reserve(std::ranges::size(from));
+    }
+    for (const auto& f : from) {
+        to.push_back(detail::convert<To>(f));
+    }
+    return to;
+}
+
+} // namespace trezz
@@ -0,0 +1,185 @@
+#include "convert.h"
+#include "doctest/doctest.h"
+#include "reflstruct.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using namespace trezz;
+
+struct AddressDto
+{
+    std::string_view city{};
+
+    TREZZ_REFLSTRUCT_BEGIN(AddressDto)
+    TREZZ_REFLMEMBER(city, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+struct UserDto
+{
+    int64_t id{};
+    int32_t x{};
+    int32_t y{};
+    int32_t z{};
+    std::string_view user_name{};
+    int32_t age{};
+    AddressDto address{};
+
+    TREZZ_REFLSTRUCT_BEGIN(UserDto)
+    TREZZ_REFLMEMBER(id, "")
+    TREZZ_REFLMEMBER(x, "")
+    TREZZ_REFLMEMBER(y, "")
+    TREZZ_REFLMEMBER(z, "")
+    TREZZ_REFLMEMBER(user_name, "")
+    TREZZ_REFLMEMBER(age, "")
+    TREZZ_REFLMEMBER(address, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+struct Address
+{
+    std::string city{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Address)
+    TREZZ_REFLMEMBER(city, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+struct User
+{
+    int64_t id{};
+    int32_t x{};
+    int32_t y{};
+    int32_t z{};
+    std::string name{};
+    int64_t age{};
+    Address address{};
+    int unmatched{ 7 };
+
+    TREZZ_REFLSTRUCT_BEGIN(User)
+    TREZZ_REFLMEMBER(id, "")
+    TREZZ_REFLMEMBER(x, "")
+    TREZZ_REFLMEMBER(y, "")
+    TREZZ_REFLMEMBER(z, "")
+    TREZZ_REFLMEMBER(name, "map:from=user_name")
+    TREZZ_REFLMEMBER(age, "")
+    TREZZ_REFLMEMBER(address, "")
+    TREZZ_REFLMEMBER(unmatched, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+// Members are reflected in a different order than they are declared: they cannot be fused.
+struct Point
+{
+    int32_t x{};
+    int32_t y{};
+    int32_t z{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Point)
+    TREZZ_REFLMEMBER(x, "")
+    TREZZ_REFLMEMBER(z, "")
+    TREZZ_REFLMEMBER(y, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+struct Coordinates
+{
+    int32_t x{};
+    int32_t y{};
+    int16_t z{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Coordinates)
+    TREZZ_REFLMEMBER(x, "")
+    TREZZ_REFLMEMBER(y, "")
+    TREZZ_REFLMEMBER(z, "map:narrow")
+    TREZZ_REFLSTRUCT_END
+};
+
+using UserPlan = reflected_t<User>;
+using UserDtoPlan = reflected_t<const UserDto>;
+
+// id, x, y and z are fused, name, age and address are converted, unmatched is skipped.
+static_assert(detail::convert_plan_v<UserPlan, UserDtoPlan>.size == 4);
+static_assert(detail::convert_plan_v<UserPlan, UserDtoPlan>.steps[0].count == 4);
+static_assert(detail::convert_plan_v<UserPlan, UserDtoPlan>.steps[0].bulk);
+static_assert(!detail::convert_plan_v<UserPlan, UserDtoPlan>.steps[2].bulk);
+
+TEST_CASE("convert")
+{
+    const UserDto dto{
+        .id = 1,
+        .x = 2,
+        .y = 3,
+        .z = 4,
+        .user_name = "Alice",
+        .age = 42,
+        .address = { .city = "Paris" },
+    };
+
+    const auto user = convert<User>(dto);
+    CHECK(user.id == 1);
+    CHECK(user.x == 2);
+    CHECK(user.y == 3);
+    CHECK(user.z == 4);
+    CHECK(user.name == "Alice");
+    CHECK(user.age == 42);
+    CHECK(user.address.city == "Paris");
+    CHECK(user.unmatched == 7);
+
+    const auto point = convert<Point>(dto);
+    CHECK(point.x == 2);
+    CHECK(point.y == 3);
+    CHECK(point.z == 4);
+
+    const auto r = convert<reflstruct<reflmember<int64_t, "id">, reflmember<std::string, "name">>>(
+        user);
+    CHECK(r.get<"id">() == 1);
+    CHECK(r.get<"name">() == "Alice");
+}
+
+TEST_CASE("convert_all")
+{
+    std::vector<UserDto> dtos{ { .id = 1, .user_name = "Alice" }, { .id = 2, .user_name = "Bob" } };
+
+    const auto users = convert_all<User>(dtos);
+    REQUIRE(users.size() == 2);
+    CHECK(users[0].id == 1);
+    CHECK(users[0].name == "Alice");
+    CHECK(users[1].id == 2);
+    CHECK(users[1].name == "Bob");
+}
+
+TEST_CASE("convert from a reflstruct of references")
+{
+    const int32_t arr[2]{ 1, 2 };
+    const auto c1 = convert<Coordinates>(reflstruct{
+        reflmember<const int32_t&, "x">{ arr[0] },
+        reflmember<const int32_t&, "y">{ arr[1] },
+    });
+    CHECK(c1.x == 1);
+    CHECK(c1.y == 2);
+
+    // Same reflstruct type, referencing members that are not laid out contiguously.
+    const int32_t a0 = 10;
+    const int32_t pad[4]{};
+    const int32_t a1 = 20;
+    std::ignore = pad;
+    const auto c2 = convert<Coordinates>(reflstruct{
+        reflmember<const int32_t&, "x">{ a0 },
+        reflmember<const int32_t&, "y">{ a1 },
+    });
+    CHECK(c2.x == 10);
+    CHECK(c2.y == 20);
+}
+
+TEST_CASE("convert narrowing members")
+{
+    const auto c = convert<Coordinates>(UserDto{ .x = 1, .y = 2, .z = 3 });
+    CHECK(c.x == 1);
+    CHECK(c.y == 2);
+    CHECK(c.z == 3);
+}
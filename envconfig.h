@@ -1,37 +1,36 @@
 #pragma once
 
+#include "intern.h"
 #include "reflstruct.h"
 
 #include <cstdlib>
-#include <exception>
 #include <functional>
 #include <string>
 #include <type_traits>
 
 namespace trezz::envconfig {
 
-struct exception : public std::exception
+struct exception : public ::trezz::exception
 {
-    explicit exception(std::string message)
-      : _message{ std::move(message) }
-    {
-    }
-
-    const char* what() const noexcept override { return _message.data(); }
-
-private:
-    std::string _message{};
+    using ::trezz::exception::exception;
 };
 
 namespace detail {
 
-template<typename T>
+// Parse the given value into dest. std::string_view members are only supported when Intern is
+// true: they are then views on a string of the global intern pool.
+template<bool Intern = false, typename T>
 constexpr void process(std::string_view value, T& dest)
 {
     using D = std::decay_t<decltype(dest)>;
 
     if constexpr (std::is_same_v<D, std::string>) {
         dest = std::string(value);
+    } else if constexpr (std::is_same_v<D, intern::string>) {
+        dest = intern::global_pool().intern(value);
+    } else if constexpr (std::is_same_v<D, std::string_view>) {
+        static_assert(Intern, "std::string_view members require the intern element");
+        dest = intern::global_pool().intern(value).view();
     } else if constexpr (std::is_integral_v<D>) {
         const auto i = std::stoll(std::string(value));
         dest = i;
@@ -47,7 +46,7 @@ constexpr size_t is_invalid_annotation()
         return 0;
     } else {
         constexpr auto element = annotation::get<Annotation, "envconfig", N>();
-        if constexpr (element == "ignore" || element == "required" ||
+        if constexpr (element == "ignore" || element == "required" || element == "intern" ||
                       element.starts_with("name=")) {
             return is_invalid_annotation<Annotation, N - 1>();
         } else {
@@ -88,6 +87,14 @@ void process(T& dest, const Fn& env_getter)
             return;
         }
 
+        // intern::string members are always interned. The intern element is required to decode
+        // std::string_view members, and only checks the member type of intern::string members.
+        constexpr bool interned = annotation::has<M::annotation, "envconfig", "intern">();
+        using V = std::remove_cvref_t<typename M::value_type>;
+        static_assert(!interned || std::is_same_v<V, intern::string> ||
+                          std::is_same_v<V, std::string_view>,
+                      "intern requires a trezz::intern::string or std::string_view member");
+
         constexpr auto name =
             annotation::get<M::annotation, "envconfig", "name", M::literal_name>();
 
@@ -106,7 +113,7 @@ void process(T& dest, const Fn& env_getter)
             }
         }
 
-        detail::process(value, member.value);
+        detail::process<interned>(value, member.value);
     });
 }
 
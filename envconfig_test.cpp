@@ -15,6 +15,7 @@ static_assert(envconfig::is_invalid_annotation<"envconfig:required,ignore">() ==
 static_assert(envconfig::is_invalid_annotation<"envconfig:default">() == 1);
 static_assert(envconfig::is_invalid_annotation<"envconfig:ignore,name=MYNAME">() == 0);
 static_assert(envconfig::is_invalid_annotation<"envconfig:required,unknown,ignore">() == 2);
+static_assert(envconfig::is_invalid_annotation<"envconfig:name=HOST,intern">() == 0);
 
 TEST_CASE("envconfig::process nominal")
 {
@@ -98,3 +99,45 @@ TEST_CASE("envconfig::process in struct")
     const trezz::reflstruct r2 = Person::make_trezz_reflstruct(p2);
     std::ignore = r2;
 }
+
+struct Record
+{
+    intern::string host{};
+    intern::string region{};
+    intern::string zone{};
+    std::string_view rack{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Record)
+    TREZZ_REFLMEMBER(host, "envconfig:name=MY_HOST,intern")
+    TREZZ_REFLMEMBER(region, "envconfig:name=MY_REGION,intern")
+    TREZZ_REFLMEMBER(zone, "envconfig:name=MY_ZONE")
+    TREZZ_REFLMEMBER(rack, "envconfig:name=MY_RACK,intern")
+    TREZZ_REFLSTRUCT_END
+};
+
+TEST_CASE("envconfig::process interned members")
+{
+    env["MY_HOST"] = "example.com";
+    env["MY_REGION"] = "example.com";
+    env["MY_ZONE"] = "example.com";
+    env["MY_RACK"] = "example.com";
+
+    Record r1{};
+    Record r2{};
+    CHECK_NOTHROW(envconfig::detail::process(r1, env_getter));
+    CHECK_NOTHROW(envconfig::detail::process(r2, env_getter));
+
+    CHECK(r1.host == "example.com");
+    CHECK(r1.host == r2.host);
+    CHECK(r1.host == r1.region);
+    CHECK(r1.host.id() == r2.region.id());
+
+    // intern::string members are interned without the intern element.
+    CHECK(r1.zone == r1.host);
+    CHECK(r1.zone.id() == r2.zone.id());
+
+    // std::string_view members with the intern element are views on the pooled string.
+    CHECK(r1.rack == "example.com");
+    CHECK(r1.rack.data() == r2.rack.data());
+    CHECK(static_cast<const void*>(r1.rack.data()) == r1.host.view().data());
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace trezz::intern {
+
+/*
+
+String interning for members holding a small set of values repeated across many records (host
+names, region names, ...).
+
+A trezz::intern::string is a handle on a string owned by a trezz::intern::pool. Two handles
+obtained from the same pool compare equal if and only if they point to the same pooled string, so
+equality and hashing are pointer operations.
+
+Decoders built on reflstruct intern every trezz::intern::string member into the global pool,
+because of its type. The `intern` element of their annotation configuration lets them decode
+std::string_view members as views on strings of the global pool; on trezz::intern::string
+members, it only checks the member type:
+
+    struct record {
+        trezz::intern::string host{};
+        std::string_view region{};
+
+        TREZZ_REFLSTRUCT_BEGIN(record)
+        TREZZ_REFLMEMBER(host, "envconfig:name=HOST")
+        TREZZ_REFLMEMBER(region, "envconfig:name=REGION,intern")
+        TREZZ_REFLSTRUCT_END
+    };
+
+*/
+
+class pool;
+
+// Handle on a string interned in a pool.
+class string
+{
+public:
+    // Construct a handle on the empty string.
+    constexpr string() = default;
+
+    // Return the interned string.
+    constexpr std::string_view view() const noexcept
+    {
+        return _s == nullptr ? std::string_view{} : std::string_view{ *_s };
+    }
+
+    constexpr operator std::string_view() const noexcept { return view(); }
+
+    constexpr bool empty() const noexcept { return _s == nullptr; }
+
+    constexpr size_t size() const noexcept { return view().size(); }
+
+    // Compare handles by identity. Both handles must come from the same pool.
+    constexpr bool operator==(const string& other) const noexcept { return _s == other._s; }
+
+    // Compare the interned string with the given one.
+    constexpr bool operator==(std::string_view other) const noexcept { return view() == other; }
+
+    // Compare the interned string with the given one, lexicographically.
+    constexpr auto operator<=>(std::string_view other) const noexcept { return view() <=> other; }
+
+    // Return the address of the pooled string, unique per distinct value within a pool.
+    constexpr const void* id() const noexcept { return _s; }
+
+private:
+    friend class pool;
+
+    explicit constexpr string(const std::string* s) noexcept
+      : _s{ s }
+    {
+    }
+
+    // Pooled string, or nullptr for the empty string.
+    const std::string* _s{ nullptr };
+};
+
+// Thread-safe set of interned strings. Interned strings live as long as the pool.
+class pool
+{
+public:
+    pool() = default;
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    // Return the handle on the given string, interning it if it is not already in the pool.
+    string intern(std::string_view s)
+    {
+        if (s.empty()) {
+            return {};
+        }
+
+        {
+            std::shared_lock lock{ _mutex };
+            if (const auto it = _strings.find(s); it != _strings.end()) {
+                return string{ &*it };
+            }
+        }
+
+        std::unique_lock lock{ _mutex };
+        const auto [it, inserted] = _strings.emplace(s);
+        return string{ &*it };
+    }
+
+    // Return the number of distinct strings in the pool.
+    size_t size() const
+    {
+        std::shared_lock lock{ _mutex };
+        return _strings.size();
+    }
+
+private:
+    struct hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const noexcept
+        {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
+
+    mutable std::shared_mutex _mutex{};
+
+    // Node-based container: element addresses are stable across insertions.
+    std::unordered_set<std::string, hash, std::equal_to<>> _strings{};
+};
+
+// Return the process-wide pool used by decoders.
+inline pool& global_pool()
+{
+    static pool p{};
+    return p;
+}
+
+} // namespace trezz::intern
+
+template<>
+struct std::hash<trezz::intern::string>
+{
+    size_t operator()(const trezz::intern::string& s) const noexcept
+    {
+        return std::hash<const void*>{}(s.id());
+    }
+};
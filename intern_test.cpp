@@ -0,0 +1,66 @@
+#include "doctest/doctest.h"
+#include "intern.h"
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace trezz;
+
+TEST_CASE("intern::pool")
+{
+    intern::pool pool{};
+
+    const auto a = pool.intern("example.com");
+    const auto b = pool.intern(std::string("example.com"));
+    const auto c = pool.intern("example.org");
+
+    CHECK(pool.size() == 2);
+    CHECK(a == b);
+    CHECK(a.id() == b.id());
+    CHECK(!(a == c));
+    CHECK(a == "example.com");
+    CHECK(c.view() == "example.org");
+
+    CHECK(pool.intern("") == intern::string{});
+    CHECK(intern::string{}.empty());
+    CHECK(intern::string{}.view().empty());
+    CHECK(pool.size() == 2);
+
+    std::unordered_set<intern::string> hosts{ a, b, c };
+    CHECK(hosts.size() == 2);
+}
+
+TEST_CASE("intern::pool concurrent")
+{
+    intern::pool pool{};
+
+    constexpr size_t nb_threads = 8;
+    constexpr size_t nb_strings = 64;
+
+    // Each thread interns the same strings, starting at a different offset.
+    std::vector<std::vector<intern::string>> handles(nb_threads);
+    std::vector<std::thread> threads{};
+    for (size_t t = 0; t < nb_threads; ++t) {
+        threads.emplace_back([&, t] {
+            handles[t].resize(nb_strings);
+            for (size_t i = 0; i < nb_strings; ++i) {
+                const auto k = (i + t * 7) % nb_strings;
+                handles[t][k] = pool.intern("host-" + std::to_string(k));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    CHECK(pool.size() == nb_strings);
+    for (size_t k = 0; k < nb_strings; ++k) {
+        CHECK(handles[0][k] == "host-" + std::to_string(k));
+        for (size_t t = 1; t < nb_threads; ++t) {
+            CHECK(handles[t][k] == handles[0][k]);
+        }
+    }
+}
@@ -0,0 +1,678 @@
+#pragma once
+
+#include "reflstruct.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace trezz::query {
+
+/*
+
+Filter collections of reflected structs with predicates on member names.
+
+A query is built from predicates on members combined with &&, || and !:
+
+    auto q = query::where<"port">(query::gt, 1024) && query::where<"host">(query::eq, "x");
+
+and evaluated over either rows or columns:
+  * rows: a contiguous range of reflstruct or reflected structs, e.g. std::vector<service>;
+  * columns: a reflstruct or reflected struct whose members are std::vector of the same size.
+
+Evaluation is column-at-a-time: each predicate scans one member over the whole collection in
+blocks of 64 rows and produces a selection bitmap. The comparison loop of a block is branchless
+with a constant trip count, so that compilers vectorize it on contiguous columns at -O2 (GCC 12
+and later) or -O3. Predicates are combined with bitwise operations on bitmaps.
+
+Integer members are compared with integer values by value, regardless of their signedness, as
+with std::cmp_less.
+
+Predicates can also be built at runtime from member names, operators and values given as strings
+with query::dynamic_where.
+
+*/
+
+struct exception : public ::trezz::exception
+{
+    using ::trezz::exception::exception;
+};
+
+// Set of selected rows of a collection, stored as a bitmap.
+class selection
+{
+public:
+    static constexpr size_t word_bits{ 64 };
+
+    selection() = default;
+
+    // Construct a selection of the given size, with all rows selected or not.
+    explicit selection(size_t size, bool selected = false)
+      : _size{ size }
+      , _words((size + word_bits - 1) / word_bits, selected ? ~uint64_t{ 0 } : 0)
+    {
+        clear_tail();
+    }
+
+    // Number of rows in the collection.
+    size_t size() const noexcept { return _size; }
+
+    // Number of selected rows.
+    size_t count() const noexcept
+    {
+        size_t n = 0;
+        for (const auto w : _words) {
+            n += std::popcount(w);
+        }
+        return n;
+    }
+
+    // Return true if the row at the given index is selected, false otherwise.
+    bool test(size_t i) const noexcept
+    {
+        return (_words[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    // Call the given function with the index of each selected row, in increasing order.
+    template<typename Fn>
+    void each(const Fn& f) const
+    {
+        for (size_t w = 0; w < _words.size(); ++w) {
+            for (auto bits = _words[w]; bits != 0; bits &= bits - 1) {
+                f(w * word_bits + std::countr_zero(bits));
+            }
+        }
+    }
+
+    // Return the indices of the selected rows, in increasing order.
+    std::vector<size_t> indices() const
+    {
+        std::vector<size_t> v{};
+        v.reserve(count());
+        each([&](size_t i) { v.push_back(i); });
+        return v;
+    }
+
+    std::vector<uint64_t>& words() noexcept { return _words; }
+    const std::vector<uint64_t>& words() const noexcept { return _words; }
+
+    // Combine with a selection of the same size.
+    // An exception of type trezz::query::exception is thrown if the sizes differ.
+    selection& operator&=(const selection& other)
+    {
+        check_size(other);
+        for (size_t i = 0; i < _words.size(); ++i) {
+            _words[i] &= other._words[i];
+        }
+        return *this;
+    }
+
+    // Combine with a selection of the same size.
+    // An exception of type trezz::query::exception is thrown if the sizes differ.
+    selection& operator|=(const selection& other)
+    {
+        check_size(other);
+        for (size_t i = 0; i < _words.size(); ++i) {
+            _words[i] |= other._words[i];
+        }
+        return *this;
+    }
+
+    selection operator~() const
+    {
+        selection s{ *this };
+        for (auto& w : s._words) {
+            w = ~w;
+        }
+        s.clear_tail();
+        return s;
+    }
+
+    friend selection operator&(selection l, const selection& r) { return l &= r; }
+    friend selection operator|(selection l, const selection& r) { return l |= r; }
+
+    bool operator==(const selection&) const = default;
+
+private:
+    void check_size(const selection& other) const
+    {
+        if (_size != other._size) {
+            throw query::exception("selections of different sizes: " + std::to_string(_size) +
+                                   " and " + std::to_string(other._size));
+        }
+    }
+
+    // Unset the bits past the end of the collection.
+    void clear_tail() noexcept
+    {
+        if (const auto rem = _size % word_bits; rem != 0) {
+            _words.back() &= (uint64_t{ 1 } << rem) - 1;
+        }
+    }
+
+    size_t _size{};
+    std::vector<uint64_t> _words{};
+};
+
+template<typename A, typename B>
+concept equality_comparable = requires(const A& a, const B& b) {
+    { a == b } -> std::convertible_to<bool>;
+};
+
+template<typename A, typename B>
+concept less_than_comparable = requires(const A& a, const B& b) {
+    { a < b } -> std::convertible_to<bool>;
+};
+
+template<typename A, typename B>
+concept less_equal_comparable = requires(const A& a, const B& b) {
+    { a <= b } -> std::convertible_to<bool>;
+};
+
+template<typename A, typename B>
+concept greater_than_comparable = requires(const A& a, const B& b) {
+    { a > b } -> std::convertible_to<bool>;
+};
+
+template<typename A, typename B>
+concept greater_equal_comparable = requires(const A& a, const B& b) {
+    { a >= b } -> std::convertible_to<bool>;
+};
+
+namespace detail {
+
+// True if T is an integer type accepted by std::cmp_equal and related functions.
+template<typename T>
+concept cmp_integer = std::integral<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                      !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                      !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+// True if values of types A and B are compared with std::cmp_equal and related functions.
+template<typename A, typename B>
+concept cmp_integers = cmp_integer<A> && cmp_integer<B>;
+
+} // namespace detail
+
+// Comparison operators usable in predicates.
+
+struct eq_t
+{
+    static constexpr std::string_view symbol{ "==" };
+
+    template<typename A, typename B>
+    requires equality_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_equal(a, b);
+        } else {
+            return a == b;
+        }
+    }
+};
+
+struct ne_t
+{
+    static constexpr std::string_view symbol{ "!=" };
+
+    template<typename A, typename B>
+    requires equality_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_not_equal(a, b);
+        } else {
+            return !(a == b);
+        }
+    }
+};
+
+struct lt_t
+{
+    static constexpr std::string_view symbol{ "<" };
+
+    template<typename A, typename B>
+    requires less_than_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_less(a, b);
+        } else {
+            return a < b;
+        }
+    }
+};
+
+struct le_t
+{
+    static constexpr std::string_view symbol{ "<=" };
+
+    template<typename A, typename B>
+    requires less_equal_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_less_equal(a, b);
+        } else {
+            return a <= b;
+        }
+    }
+};
+
+struct gt_t
+{
+    static constexpr std::string_view symbol{ ">" };
+
+    template<typename A, typename B>
+    requires greater_than_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_greater(a, b);
+        } else {
+            return a > b;
+        }
+    }
+};
+
+struct ge_t
+{
+    static constexpr std::string_view symbol{ ">=" };
+
+    template<typename A, typename B>
+    requires greater_equal_comparable<A, B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        if constexpr (detail::cmp_integers<A, B>) {
+            return std::cmp_greater_equal(a, b);
+        } else {
+            return a >= b;
+        }
+    }
+};
+
+inline constexpr eq_t eq{};
+inline constexpr ne_t ne{};
+inline constexpr lt_t lt{};
+inline constexpr le_t le{};
+inline constexpr gt_t gt{};
+inline constexpr ge_t ge{};
+
+// Parent type of all query expressions.
+struct base_expression
+{};
+
+template<typename T>
+concept expression = std::is_base_of_v<base_expression, std::remove_cvref_t<T>>;
+
+namespace detail {
+
+// True if the source is a contiguous collection of rows, false if it is a set of columns.
+template<typename Source>
+inline constexpr bool is_rows = std::ranges::contiguous_range<Source>;
+
+// Return the position of the first member of the reflstruct that is a sized range.
+template<typename R, size_t N = 0>
+constexpr size_t first_column()
+{
+    using V = std::remove_cvref_t<typename R::template member_type<N>::value_type>;
+    if constexpr (std::ranges::sized_range<V>) {
+        return N;
+    } else {
+        return first_column<R, N + 1>();
+    }
+}
+
+// Call the given function with the number of rows of the source and an accessor returning the
+// value of the given member at a row index.
+// In a set of columns, the number of rows is the size of the first column. An exception of type
+// trezz::query::exception is thrown if the given member has a different size.
+template<trezz::detail::string_literal Name, typename Source, typename Fn>
+constexpr decltype(auto) with_column(const Source& src, const Fn& f)
+{
+    if constexpr (is_rows<Source>) {
+        const auto* rows = std::ranges::data(src);
+        return f(std::ranges::size(src),
+                 [rows](size_t i) -> decltype(auto) {
+                     return reflect(rows[i]).template get<Name>();
+                 });
+    } else {
+        const auto& columns = reflect(src);
+        using R = std::remove_cvref_t<decltype(columns)>;
+
+        const auto& column = columns.template get<Name>();
+        const size_t n = std::ranges::size(columns.template member_at<first_column<R>()>().value);
+        if (std::ranges::size(column) != n) {
+            throw query::exception("column '" + std::string(Name.data) + "' has " +
+                                   std::to_string(std::ranges::size(column)) + " rows instead of " +
+                                   std::to_string(n));
+        }
+
+        const auto* values = std::ranges::data(column);
+        return f(n, [values](size_t i) -> const auto& { return values[i]; });
+    }
+}
+
+// Return the bitmap word of the comparison results of a block, each 0 or 1.
+inline uint64_t pack(const uint8_t (&block)[selection::word_bits])
+{
+    uint64_t bits = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        // The product of 8 bytes holding 0 or 1 with this constant gathers them in its high byte,
+        // without carries.
+        for (size_t i = 0; i < selection::word_bits / 8; ++i) {
+            uint64_t bytes{};
+            std::memcpy(&bytes, block + 8 * i, 8);
+            bits |= ((bytes * 0x0102040810204080) >> 56) << (8 * i);
+        }
+    } else {
+        for (size_t i = 0; i < selection::word_bits; ++i) {
+            bits |= uint64_t{ block[i] } << i;
+        }
+    }
+    return bits;
+}
+
+// Fill the selection with the result of the comparison of each value returned by the accessor
+// with the given value.
+template<typename Op, typename Get, typename V>
+void scan(selection& sel, const Get& get, const V& value)
+{
+    constexpr size_t word_bits = selection::word_bits;
+    const size_t n = sel.size();
+    const size_t full_words = n / word_bits;
+    auto& words = sel.words();
+
+    // Comparison results of a block, as bytes so that the comparison loop vectorizes.
+    uint8_t block[word_bits]{};
+
+    for (size_t w = 0; w < full_words; ++w) {
+        const size_t begin = w * word_bits;
+        for (size_t i = 0; i < word_bits; ++i) {
+            block[i] = Op{}(get(begin + i), value);
+        }
+        words[w] = pack(block);
+    }
+
+    if (const size_t rem = n % word_bits; rem != 0) {
+        const size_t begin = full_words * word_bits;
+        for (size_t i = 0; i < rem; ++i) {
+            block[i] = Op{}(get(begin + i), value);
+        }
+        std::fill(std::begin(block) + rem, std::end(block), uint8_t{ 0 });
+        words[full_words] = pack(block);
+    }
+}
+
+// Type used to store the value compared to members: character strings are held as views.
+template<typename V>
+using stored_t = std::conditional_t<std::is_convertible_v<std::decay_t<V>, const char*>,
+                                    std::string_view,
+                                    std::decay_t<V>>;
+
+} // namespace detail
+
+// Predicate comparing the member of the given name with a value.
+template<trezz::detail::string_literal Name, typename Op, typename V>
+struct predicate : base_expression
+{
+    // Compared member name.
+    static constexpr std::string_view name{ Name.data };
+
+    V value{};
+
+    template<typename Source>
+    selection evaluate(const Source& src) const
+    {
+        return detail::with_column<Name>(src, [&](size_t n, const auto& get) {
+            selection sel{ n };
+            detail::scan<Op>(sel, get, value);
+            return sel;
+        });
+    }
+};
+
+template<typename L, typename R>
+struct and_expression : base_expression
+{
+    L l{};
+    R r{};
+
+    template<typename Source>
+    selection evaluate(const Source& src) const
+    {
+        return l.evaluate(src) & r.evaluate(src);
+    }
+};
+
+template<typename L, typename R>
+struct or_expression : base_expression
+{
+    L l{};
+    R r{};
+
+    template<typename Source>
+    selection evaluate(const Source& src) const
+    {
+        return l.evaluate(src) | r.evaluate(src);
+    }
+};
+
+template<typename E>
+struct not_expression : base_expression
+{
+    E e{};
+
+    template<typename Source>
+    selection evaluate(const Source& src) const
+    {
+        return ~e.evaluate(src);
+    }
+};
+
+// Return a predicate comparing the member of the given name with the given value.
+template<trezz::detail::string_literal Name, typename Op, typename V>
+constexpr auto where(Op, V&& value)
+{
+    using S = detail::stored_t<V>;
+    return predicate<Name, Op, S>{ {}, S(std::forward<V>(value)) };
+}
+
+template<expression L, expression R>
+constexpr auto operator&&(L&& l, R&& r)
+{
+    return and_expression<std::remove_cvref_t<L>, std::remove_cvref_t<R>>{ {},
+                                                                            std::forward<L>(l),
+                                                                            std::forward<R>(r) };
+}
+
+template<expression L, expression R>
+constexpr auto operator||(L&& l, R&& r)
+{
+    return or_expression<std::remove_cvref_t<L>, std::remove_cvref_t<R>>{ {},
+                                                                           std::forward<L>(l),
+                                                                           std::forward<R>(r) };
+}
+
+template<expression E>
+constexpr auto operator!(E&& e)
+{
+    return not_expression<std::remove_cvref_t<E>>{ {}, std::forward<E>(e) };
+}
+
+// Return the selection of the rows of the source matching the given expression.
+template<expression E, typename Source>
+selection evaluate(const E& e, const Source& src)
+{
+    return e.evaluate(src);
+}
+
+// Predicate built at runtime, evaluated over sources of the given type.
+template<typename Source>
+struct dynamic_predicate : base_expression
+{
+    std::function<selection(const Source&)> fn{};
+
+    selection evaluate(const Source& src) const { return fn(src); }
+};
+
+namespace detail {
+
+// Parse the given string as a value of the given type.
+template<typename T>
+T parse_value(std::string_view name, std::string_view s)
+{
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        T v{};
+        const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+        if (ec != std::errc{} || ptr != s.data() + s.size()) {
+            throw query::exception("invalid value '" + std::string(s) + "' for member '" +
+                                   std::string(name) + "'");
+        }
+        return v;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (s == "true") {
+            return true;
+        } else if (s == "false") {
+            return false;
+        }
+        throw query::exception("invalid value '" + std::string(s) + "' for member '" +
+                               std::string(name) + "'");
+    } else {
+        return T(s);
+    }
+}
+
+// Type of the rows of the source: the elements of a range of rows, or the set of columns itself.
+template<typename Source>
+struct row
+{
+    using type = Source;
+};
+
+template<typename Source>
+requires is_rows<Source>
+struct row<Source>
+{
+    using type = std::ranges::range_value_t<Source>;
+};
+
+// Type of the values of a member of the given source, or void if the member of a set of columns
+// is not a range.
+template<typename Source, typename Member>
+struct member_value
+{
+    using type = void;
+};
+
+template<typename Source, typename Member>
+requires(!is_rows<Source> && std::ranges::range<std::remove_cvref_t<typename Member::value_type>>)
+struct member_value<Source, Member>
+{
+    using type = std::ranges::range_value_t<std::remove_cvref_t<typename Member::value_type>>;
+};
+
+template<typename Source, typename Member>
+requires is_rows<Source>
+struct member_value<Source, Member>
+{
+    using type = std::remove_cvref_t<typename Member::value_type>;
+};
+
+// Type used to store the parsed value compared to members of the given type.
+template<typename V>
+using dynamic_stored_t = std::conditional_t<std::is_arithmetic_v<V>, V, std::string>;
+
+// True if members of the given type can be compared with the given operator to a parsed value.
+template<typename V, typename Op>
+concept dynamic_comparable =
+    !std::is_void_v<V> && std::is_invocable_r_v<bool, Op, const V&, const dynamic_stored_t<V>&>;
+
+template<typename Source, typename Op, typename Member>
+dynamic_predicate<Source> make_dynamic(std::string_view value)
+{
+    using V = typename member_value<Source, Member>::type;
+
+    if constexpr (!dynamic_comparable<V, Op>) {
+        throw query::exception("unsupported member type for member '" + std::string(Member::name) +
+                               "' with operator '" + std::string(Op::symbol) + "'");
+    } else {
+        using Stored = dynamic_stored_t<V>;
+        using P = predicate<Member::literal_name, Op, Stored>;
+
+        return { {},
+                 [p = P{ {}, parse_value<Stored>(Member::name, value) }](const Source& src) {
+                     return p.evaluate(src);
+                 } };
+    }
+}
+
+template<typename Source, typename Member>
+dynamic_predicate<Source> make_dynamic(std::string_view op, std::string_view value)
+{
+    if (op == eq_t::symbol) {
+        return make_dynamic<Source, eq_t, Member>(value);
+    } else if (op == ne_t::symbol) {
+        return make_dynamic<Source, ne_t, Member>(value);
+    } else if (op == lt_t::symbol) {
+        return make_dynamic<Source, lt_t, Member>(value);
+    } else if (op == le_t::symbol) {
+        return make_dynamic<Source, le_t, Member>(value);
+    } else if (op == gt_t::symbol) {
+        return make_dynamic<Source, gt_t, Member>(value);
+    } else if (op == ge_t::symbol) {
+        return make_dynamic<Source, ge_t, Member>(value);
+    }
+    throw query::exception("invalid operator '" + std::string(op) + "'");
+}
+
+// Type of the reflstruct describing the members of a row or of the columns of the source.
+template<typename Source>
+using row_reflstruct_t = reflected_t<const typename row<Source>::type>;
+
+template<typename Source, size_t N = 0>
+dynamic_predicate<Source> dynamic_where(std::string_view name,
+                                        std::string_view op,
+                                        std::string_view value)
+{
+    using R = row_reflstruct_t<Source>;
+
+    if constexpr (N < R::nb_members) {
+        using Member = typename R::template member_type<N>;
+        if (Member::name == name) {
+            return make_dynamic<Source, Member>(op, value);
+        } else {
+            return dynamic_where<Source, N + 1>(name, op, value);
+        }
+    } else {
+        throw query::exception("unknown member '" + std::string(name) + "'");
+    }
+}
+
+} // namespace detail
+
+// Return a predicate comparing the member of the given name with the given value, using the given
+// operator among "==", "!=", "<", "<=", ">" and ">=". The value is parsed according to the type of
+// the member.
+// An exception of type trezz::query::exception is thrown on error.
+template<typename Source>
+dynamic_predicate<Source> dynamic_where(std::string_view name,
+                                        std::string_view op,
+                                        std::string_view value)
+{
+    return detail::dynamic_where<Source>(name, op, value);
+}
+
+} // namespace trezz::query
@@ -0,0 +1,202 @@
+#include "doctest/doctest.h"
+#include "intern.h"
+#include "query.h"
+#include "reflstruct.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace trezz;
+
+struct Service
+{
+    int port{};
+    std::string host{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Service)
+    TREZZ_REFLMEMBER(port, "")
+    TREZZ_REFLMEMBER(host, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+struct Services
+{
+    std::vector<int> port{};
+    std::vector<intern::string> host{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Services)
+    TREZZ_REFLMEMBER(port, "")
+    TREZZ_REFLMEMBER(host, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+TEST_CASE("query::selection")
+{
+    query::selection s{ 70, true };
+    CHECK(s.size() == 70);
+    CHECK(s.count() == 70);
+    CHECK((~s).count() == 0);
+    CHECK((~query::selection{ 70 }).count() == 70);
+
+    query::selection odd{ 70 };
+    for (size_t i = 1; i < 70; i += 2) {
+        odd.words()[i / 64] |= uint64_t{ 1 } << (i % 64);
+    }
+    CHECK(odd.count() == 35);
+    CHECK(odd.test(69));
+    CHECK(!odd.test(68));
+    CHECK((odd & ~odd).count() == 0);
+    CHECK((odd | ~odd) == s);
+    CHECK(odd.indices().front() == 1);
+    CHECK(odd.indices().back() == 69);
+
+    CHECK_THROWS_WITH(s & query::selection{ 64 }, "selections of different sizes: 70 and 64");
+    CHECK_THROWS_AS(s | query::selection{ 71 }, query::exception);
+}
+
+TEST_CASE("query over rows")
+{
+    std::vector<Service> rows{};
+    for (int i = 0; i < 200; ++i) {
+        rows.push_back({ .port = 1000 + i, .host = i % 3 == 0 ? "x" : "y" });
+    }
+
+    const auto q = query::where<"port">(query::gt, 1024) && query::where<"host">(query::eq, "x");
+    const auto sel = query::evaluate(q, rows);
+
+    CHECK(sel.size() == rows.size());
+    size_t expected = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const bool match = rows[i].port > 1024 && rows[i].host == "x";
+        expected += match;
+        CHECK(sel.test(i) == match);
+    }
+    CHECK(sel.count() == expected);
+
+    CHECK(query::evaluate(!q, rows) == ~sel);
+    CHECK(query::evaluate(q || query::where<"port">(query::le, 1001), rows).count() ==
+          expected + 2);
+
+    std::vector<reflstruct<reflmember<int, "port">>> rrows{};
+    rrows.emplace_back(reflmember<int, "port">{ 1 });
+    rrows.emplace_back(reflmember<int, "port">{ 2 });
+    CHECK(query::evaluate(query::where<"port">(query::ne, 1), rrows).indices() ==
+          std::vector<size_t>{ 1 });
+}
+
+TEST_CASE("query over columns")
+{
+    intern::pool pool{};
+
+    Services cols{};
+    for (int i = 0; i < 130; ++i) {
+        cols.port.push_back(i);
+        cols.host.push_back(pool.intern(i < 65 ? "a" : "b"));
+    }
+
+    CHECK(query::evaluate(query::where<"port">(query::lt, 10), cols).count() == 10);
+    CHECK(query::evaluate(query::where<"host">(query::eq, "b"), cols).count() == 65);
+    CHECK(query::evaluate(query::where<"host">(query::eq, "b") &&
+                              query::where<"port">(query::ge, 128),
+                          cols)
+              .indices() == std::vector<size_t>{ 128, 129 });
+
+    const reflstruct rcols{
+        reflmember<std::vector<double>, "ratio">{ { 0.5, 1.5, 2.5 } },
+    };
+    CHECK(query::evaluate(query::where<"ratio">(query::gt, 1.0), rcols).count() == 2);
+
+    Services short_host{ .port = { 1, 2, 3, 4 }, .host = { pool.intern("a") } };
+    CHECK_THROWS_WITH(query::evaluate(query::where<"host">(query::eq, "a") ||
+                                          query::where<"port">(query::gt, 0),
+                                      short_host),
+                      "column 'host' has 1 rows instead of 4");
+}
+
+TEST_CASE("query comparisons")
+{
+    const reflstruct cols{
+        reflmember<std::vector<double>, "d">{
+            { 1.0, std::numeric_limits<double>::quiet_NaN(), 3.0 } },
+        reflmember<std::vector<uint32_t>, "u">{ { 0, 1, 4000000000 } },
+    };
+
+    // NaN matches no ordering comparison.
+    CHECK(query::evaluate(query::where<"d">(query::le, 2.0), cols).indices() ==
+          std::vector<size_t>{ 0 });
+    CHECK(query::evaluate(query::where<"d">(query::ge, 0.0), cols).indices() ==
+          std::vector<size_t>{ 0, 2 });
+    CHECK(query::evaluate(query::where<"d">(query::ne, 1.0), cols).count() == 2);
+
+    // Integers are compared by value, whatever their signedness.
+    CHECK(query::evaluate(query::where<"u">(query::gt, -1), cols).count() == 3);
+    CHECK(query::evaluate(query::where<"u">(query::eq, -1), cols).count() == 0);
+    CHECK(query::evaluate(query::where<"u">(query::lt, 2), cols).count() == 2);
+    CHECK(query::evaluate(query::where<"u">(query::ge, int64_t{ 4000000000 }), cols).count() == 1);
+
+    std::vector<reflstruct<reflmember<double, "d">>> rows(2);
+    rows[1].get<"d">() = std::numeric_limits<double>::quiet_NaN();
+    using Rows = decltype(rows);
+    CHECK(query::evaluate(query::dynamic_where<Rows>("d", "<=", "2"), rows).indices() ==
+          std::vector<size_t>{ 0 });
+    CHECK(query::evaluate(query::dynamic_where<Rows>("d", ">=", "0"), rows).indices() ==
+          std::vector<size_t>{ 0 });
+}
+
+enum class Protocol
+{
+    http,
+    https,
+};
+
+struct Endpoint
+{
+    int port{};
+    std::vector<int> tags{};
+    Protocol protocol{};
+    Service service{};
+
+    TREZZ_REFLSTRUCT_BEGIN(Endpoint)
+    TREZZ_REFLMEMBER(port, "")
+    TREZZ_REFLMEMBER(tags, "")
+    TREZZ_REFLMEMBER(protocol, "")
+    TREZZ_REFLMEMBER(service, "")
+    TREZZ_REFLSTRUCT_END
+};
+
+TEST_CASE("query::dynamic_where")
+{
+    std::vector<Service> rows{
+        { .port = 80, .host = "x" },
+        { .port = 8080, .host = "x" },
+        { .port = 8081, .host = "y" },
+    };
+
+    const auto q = query::dynamic_where<std::vector<Service>>("port", ">", "1024") &&
+                   query::dynamic_where<std::vector<Service>>("host", "==", "x");
+    CHECK(query::evaluate(q, rows).indices() == std::vector<size_t>{ 1 });
+    CHECK(query::evaluate(q && query::where<"port">(query::lt, 8081), rows).count() == 1);
+
+    Services cols{ .port = { 1, 2, 3 } };
+    CHECK(query::evaluate(query::dynamic_where<Services>("port", "<=", "2"), cols).count() == 2);
+
+    CHECK_THROWS_WITH(query::dynamic_where<std::vector<Service>>("address", "==", "x"),
+                      "unknown member 'address'");
+    CHECK_THROWS_WITH(query::dynamic_where<std::vector<Service>>("port", "=~", "1"),
+                      "invalid operator '=~'");
+    CHECK_THROWS_WITH(query::dynamic_where<std::vector<Service>>("port", "==", "x"),
+                      "invalid value 'x' for member 'port'");
+
+    // Members that cannot be compared don't prevent querying the others.
+    std::vector<Endpoint> endpoints{ { .port = 80 }, { .port = 443 } };
+    const auto by_port = query::dynamic_where<std::vector<Endpoint>>("port", ">", "100");
+    CHECK(query::evaluate(by_port, endpoints).indices() == std::vector<size_t>{ 1 });
+    CHECK_THROWS_WITH(query::dynamic_where<std::vector<Endpoint>>("tags", "==", "1"),
+                      "unsupported member type for member 'tags' with operator '=='");
+    CHECK_THROWS_AS(query::dynamic_where<std::vector<Endpoint>>("protocol", "<", "http"),
+                    query::exception);
+    CHECK_THROWS_AS(query::dynamic_where<std::vector<Endpoint>>("service", "==", "x"),
+                    trezz::exception);
+}
@@ -1,11 +1,29 @@
 #pragma once
 
 #include <__tuple>
+#include <exception>
+#include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace trezz {
 
+// Parent type of the exceptions thrown by the libraries built on reflstruct.
+struct exception : public std::exception
+{
+    explicit exception(std::string message)
+      : _message{ std::move(message) }
+    {
+    }
+
+    const char* what() const noexcept override { return _message.data(); }
+
+private:
+    std::string _message{};
+};
+
 namespace detail {
 
 // Store a character string as a constexpr value that can be passed as non-type template parameter.
@@ -54,6 +72,10 @@ struct reflstruct : base_reflstruct
     // Number of members of the struct.
     static constexpr size_t nb_members{ sizeof...(Ts) };
 
+    // Type of the member at the given position.
+    template<size_t N>
+    using member_type = std::tuple_element_t<N, std::tuple<Ts...>>;
+
     constexpr reflstruct() = default;
 
     // Construct a reflstruct with reflmembers as arguments.
@@ -118,6 +140,22 @@ struct reflstruct : base_reflstruct
         }
     }
 
+    // Return the member at the given position.
+    template<size_t N>
+    constexpr auto& member_at()
+    {
+        static_assert(N < nb_members, "invalid member position");
+        return std::get<N>(_members);
+    }
+
+    // Return the member at the given position.
+    template<size_t N>
+    constexpr const auto& member_at() const
+    {
+        static_assert(N < nb_members, "invalid member position");
+        return std::get<N>(_members);
+    }
+
     // Call the given function on each members of the struct, with the member given as input
     // argument to the function.
     template<typename Fn>
@@ -150,6 +188,27 @@ private:
     std::tuple<Ts...> _members{};
 };
 
+// True if T is a reflstruct, or a struct reflected with TREZZ_REFLSTRUCT_BEGIN.
+template<typename T>
+concept reflected =
+    std::is_base_of_v<base_reflstruct, std::remove_cvref_t<T>> ||
+    requires(const std::remove_cvref_t<T>& t) { std::remove_cvref_t<T>::make_trezz_reflstruct(t); };
+
+// Return the given reflstruct, or a reflstruct of references on the members of the given struct.
+template<reflected T>
+constexpr decltype(auto) reflect(T& t)
+{
+    if constexpr (std::is_base_of_v<base_reflstruct, std::remove_const_t<T>>) {
+        return (t);
+    } else {
+        return std::remove_const_t<T>::make_trezz_reflstruct(t);
+    }
+}
+
+// Type of the reflstruct returned by reflect for a value of type T.
+template<typename T>
+using reflected_t = std::remove_cvref_t<decltype(reflect(std::declval<T&>()))>;
+
 namespace annotation {
 
 /*